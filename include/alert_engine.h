@@ -0,0 +1,103 @@
+#ifndef ALERT_ENGINE_H
+#define ALERT_ENGINE_H
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <regex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "process.h"
+#include "system.h"
+
+/*
+Threshold alerts evaluated on every sample tick
+Rules are read from a file, one per line ('#' outside quotes starts a
+comment):
+  cpu.total > 0.9 for 30s
+  mem.used >= 0.8
+  proc[cmd~"java"].rss > 8G
+  proc[user=="postgres"].cpu > 0.5 for 1m
+System metrics: cpu.total, mem.used, procs.total, procs.running
+Process metrics: cpu (0-1), rss (bytes, K/M/G suffixes)
+Filters: cmd or user, matched with == or ~ (regex search)
+*/
+class AlertEngine {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Alert {
+    std::string rule;
+    int pid;  // 0 for system rules
+    std::string subject;
+    std::string value;
+    std::string Describe() const;
+  };
+
+  // Compiles the rules in path; throws std::invalid_argument on bad syntax
+  void Load(const std::string& path);
+  void Add(const std::string& rule);
+  std::size_t Size() const { return rules_.size(); };
+  // Transitions are also written, timestamped, to log
+  void Log(std::ostream& log) { log_ = &log; };
+
+  // Must run after every System::Processes(): process rules follow the
+  // processes started and exited on each tick
+  void Evaluate(System& system, Clock::time_point now = Clock::now());
+  const std::vector<Alert>& Firing() const { return firing_; };
+  bool Firing(int pid) const { return firing_pids_.count(pid) > 0; };
+  // Lines describing alerts that started or stopped firing on the last tick
+  const std::vector<std::string>& Transitions() const { return transitions_; };
+
+ private:
+  enum class Metric {
+    kCpuTotal,
+    kMemUsed,
+    kProcsTotal,
+    kProcsRunning,
+    kProcCpu,
+    kProcRss
+  };
+  enum class Op { kGt, kGe, kLt, kLe, kEq, kNe };
+  enum class Field { kNone, kCmd, kUser };
+
+  // Condition state of a rule (per matching process for process rules)
+  struct State {
+    std::optional<Clock::time_point> since = {};
+    bool firing = false;
+  };
+
+  struct Rule {
+    std::string text;
+    Metric metric;
+    Op op;
+    double threshold;
+    Clock::duration hold;
+    Field field = Field::kNone;
+    bool regex = false;
+    std::string literal = "";
+    std::regex pattern = {};
+    State state = {};
+    // PIDS OF THE PROCESSES MATCHING THE FILTER
+    std::unordered_map<int, State> matched = {};
+  };
+
+  static Rule Compile(const std::string& text);
+  static bool Compare(Op op, double value, double threshold);
+  bool Matches(const Rule& rule, Process& process) const;
+  void Update(const Rule& rule, State& state, bool condition, int pid,
+              const std::string& subject, double value,
+              Clock::time_point now);
+
+  std::vector<Rule> rules_ = {};
+  std::vector<Alert> firing_ = {};
+  std::unordered_set<int> firing_pids_ = {};
+  std::vector<std::string> transitions_ = {};
+  std::ostream* log_ = nullptr;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef COMMAND_ARENA_H
+#define COMMAND_ARENA_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+/*
+Interned storage for process command lines
+A command line is read once per (pid, starttime) and shared between every
+process with the same (truncated) command, e.g. forked workers
+*/
+class CommandArena {
+ public:
+  CommandArena(std::size_t max_length = 256) : max_length_{max_length} {};
+  // The view stays valid until the matching Release()
+  std::string_view Intern(int pid, long starttime);
+  void Release(int pid, long starttime);
+  std::size_t Size() const { return commands_.size(); };
+
+ private:
+  using Strings = std::unordered_map<std::string, int>;
+
+  std::size_t max_length_ = 256;
+  // COMMAND STRING -> NUMBER OF PROCESSES USING IT
+  Strings commands_ = {};
+  // POINTERS TO unordered_map ELEMENTS SURVIVE REHASHING (ITERATORS DO NOT)
+  std::map<std::pair<int, long>, Strings::value_type*> processes_ = {};
+};
+
+#endif
@@ -11,9 +11,12 @@ namespace LinuxParser {
 // Paths
 const string kProcDirectory{"/proc/"};
 const string kCmdlineFilename{"/cmdline"};
+const string kCommFilename{"/comm"};
+const string kTaskDirectory{"/task/"};
 const string kCpuinfoFilename{"/cpuinfo"};
 const string kStatusFilename{"/status"};
 const string kStatFilename{"/stat"};
+const string kSmapsRollupFilename{"/smaps_rollup"};
 const string kUptimeFilename{"/uptime"};
 const string kMeminfoFilename{"/meminfo"};
 const string kVersionFilename{"/version"};
@@ -29,6 +32,10 @@ const string kSystemBuffers("Buffers:");
 const string kSystemCpu("cpu");
 const string kUserUID("Uid:");
 const string kSystemProcMem("VmRSS:");
+const string kSystemProcSwap("VmSwap:");
+const string kSmapsPss("Pss:");
+const string kSmapsPrivateClean("Private_Clean:");
+const string kSmapsPrivateDirty("Private_Dirty:");
 
 // System
 float MemoryUtilization();
@@ -59,11 +66,16 @@ long ActiveJiffies(int pid);
 long IdleJiffies();
 
 // Processes
+vector<string> StatFields(const string& path);
 string Command(int pid);
 string Ram(int pid);
 string Uid(int pid);
 string User(int pid);
+string UserName(const string& uid);
 long int UpTime(int pid);
+
+// Threads
+vector<int> Tids(int pid);
 };  // namespace LinuxParser
 
 #endif
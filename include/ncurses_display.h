@@ -3,13 +3,19 @@
 
 #include <curses.h>
 
+#include "alert_engine.h"
 #include "process.h"
 #include "system.h"
+#include "thread_sampler.h"
 
 namespace NCursesDisplay {
-void Display(System& system, int n = 10);
+void Display(System& system, AlertEngine& alerts, int n = 10);
 void DisplaySystem(System& system, WINDOW* window);
-void DisplayProcesses(std::vector<Process>& processes, WINDOW* window, int n);
+void DisplayProcesses(std::vector<Process>& processes,
+                      const AlertEngine& alerts, WINDOW* window, int n,
+                      bool memory_detail, int selected, long uptime);
+void DisplayThreads(const ThreadSampler& threads, WINDOW* window, int n);
+void DisplayAlerts(const AlertEngine& alerts, WINDOW* window);
 std::string ProgressBar(float percent);
 };  // namespace NCursesDisplay
 
@@ -1,27 +1,69 @@
 #ifndef PROCESS_H
 #define PROCESS_H
 
+#include <chrono>
+#include <optional>
 #include <string>
+#include <string_view>
 /*
 Basic class for Process representation
 It contains relevant attributes as shown below
 */
 class Process {
  public:
-  Process(int pid) : pid_{pid} {};
+  // tick: the System tick the process was first seen on
+  Process(int pid, long tick = 0) : pid_{pid}, sampled_tick_{tick} {};
   Process() = default;
   std::string Uid() const { return uid_; };
   int Pid();
-  std::string User();
-  std::string Command();
-  float CpuUtilization();
-  std::string Ram();
-  long int UpTime();
-  bool operator<(Process& a);
+  std::string User() const { return user_; };
+  std::string_view Command() const { return command_; };
+  void Command(std::string_view command) { command_ = command; };
+  float CpuUtilization() const;
+  std::string Ram() const;
+  long int UpTime(long system_uptime) const;
+  bool operator<(const Process& a) const;
+
+  // Adaptive sampling (see System::Processes)
+  void Sample(long tick, long system_uptime);
+  bool Sampled() const { return sampled_; };
+  // Tick of the last Sample(), or when first seen if never sampled
+  long SampledTick() const { return sampled_tick_; };
+  bool Active() const { return active_; };
+  long StartTime() const { return starttime_; };
+  long RamKb() const { return ram_kb_; };
+  long SwapKb() const { return swap_kb_; };
+
+  // Memory detail from smaps_rollup, read on demand (see
+  // System::SampleMemoryDetail). PssKb() and UssKb() are -1 when unknown.
+  void SampleMemoryDetail(std::chrono::steady_clock::time_point now);
+  bool MemoryDetailFresh(std::chrono::steady_clock::time_point now,
+                         std::chrono::steady_clock::duration staleness) const;
+  long PssKb() const { return pss_kb_; };
+  long UssKb() const { return uss_kb_; };
 
  private:
+  void ReadStatus(long& ram_kb, long& swap_kb, std::string& uid);
+
   int pid_ = 0;
   std::string uid_ = "";
+  std::string user_ = "";
+  // INTERNED BY System (see CommandArena)
+  std::string_view command_ = {};
+  // VALUES CACHED BY THE LAST CALL TO Sample()
+  bool sampled_ = false;
+  long sampled_tick_ = 0;
+  std::chrono::steady_clock::time_point sampled_at_ = {};
+  bool active_ = true;
+  long starttime_ = -1;
+  long active_jiffies_ = 0;
+  long ram_kb_ = 0;
+  long swap_kb_ = 0;
+  float cpu_utilization_ = 0.0f;
+  // VALUES CACHED BY THE LAST CALL TO SampleMemoryDetail()
+  std::optional<std::chrono::steady_clock::time_point> detail_time_ = {};
+  long pss_kb_ = -1;
+  long uss_kb_ = -1;
 };
 
-#endif
\ No newline at end of file
+#endif
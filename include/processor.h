@@ -3,9 +3,13 @@
 
 class Processor {
  public:
+  // Utilization over the interval between the last two calls to Sample()
   float Utilization();
+  void Sample();
 
  private:
+  bool sampled_ = false;
+  float utilization_ = 0.0f;
   long prev_total_active_time_ = 0;
   long prev_total_idle_time_ = 0;
 };
@@ -1,14 +1,29 @@
 #ifndef SYSTEM_H
 #define SYSTEM_H
 
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
+#include "command_arena.h"
 #include "process.h"
 #include "processor.h"
 
 class System {
  public:
+  enum class SortKey { kCpu, kRam, kPss, kUss, kSwap };
+
+  // idle_interval: idle processes are re-sampled every idle_interval ticks
+  // sample_budget: max processes sampled per tick (0 = unlimited)
+  // command_length: commands are truncated to this many characters
+  System(int idle_interval = 5, std::size_t sample_budget = 0,
+         std::size_t command_length = 256)
+      : commands_{command_length},
+        idle_interval_{idle_interval > 0 ? idle_interval : 1},
+        sample_budget_{sample_budget} {};
   Processor& Cpu();
   std::vector<Process>& Processes();
   float MemoryUtilization();
@@ -17,10 +32,48 @@ class System {
   int RunningProcesses();
   std::string Kernel();
   std::string OperatingSystem();
+  int SkippedProcesses() const { return skipped_processes_; };
+  // Processes first sampled (or whose pid was reused) and processes that
+  // exited on the last tick, for consumers that track processes
+  const std::vector<int>& StartedProcesses() const { return started_; };
+  const std::vector<int>& ExitedProcesses() const { return exited_; };
+  // Returns nullptr when pid is not tracked
+  Process* FindProcess(int pid);
+
+  void Sort(SortKey key) { sort_key_ = key; };
+  // Shows PSS/USS, re-reading smaps_rollup when older than staleness;
+  // throws std::invalid_argument unless staleness is positive
+  void MemoryDetail(bool enabled, std::chrono::seconds staleness) {
+    if (staleness <= std::chrono::seconds::zero()) {
+      throw std::invalid_argument("memory detail staleness must be positive");
+    }
+    memory_detail_ = enabled;
+    detail_staleness_ = staleness;
+  };
+  bool MemoryDetail() const {
+    return memory_detail_ || sort_key_ == SortKey::kPss ||
+           sort_key_ == SortKey::kUss;
+  };
+  void SampleMemoryDetail(std::size_t rows);
 
  private:
+  bool Due(int pid, const Process& process) const;
+  long Deadline(const Process& process) const;
+  double SortValue(const Process& process) const;
+
   Processor cpu_ = {};
+  CommandArena commands_;
   std::vector<Process> processes_ = {};
+  std::map<int, Process> tracked_processes_ = {};
+  std::vector<int> started_ = {};
+  std::vector<int> exited_ = {};
+  int idle_interval_ = 5;
+  std::size_t sample_budget_ = 0;
+  long tick_ = 0;
+  int skipped_processes_ = 0;
+  SortKey sort_key_ = SortKey::kCpu;
+  bool memory_detail_ = false;
+  std::chrono::seconds detail_staleness_{5};
 };
 
 #endif
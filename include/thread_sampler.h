@@ -0,0 +1,39 @@
+#ifndef THREAD_SAMPLER_H
+#define THREAD_SAMPLER_H
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+Samples the threads (/proc/<pid>/task) of one selected process
+Only the selected process is scanned, and each thread's CPU time is kept
+between ticks so its utilization is measured over the last interval
+*/
+class ThreadSampler {
+ public:
+  struct Thread {
+    int tid;
+    std::string name;
+    std::string state;
+    int processor;  // CPU the thread last ran on
+    float cpu_utilization;
+  };
+
+  // Starts sampling pid (0 stops), dropping the previous history
+  void Select(int pid);
+  int Pid() const { return pid_; };
+  void Sample();
+  // Sorted by CPU utilization (highest first); empty once the process exits
+  const std::vector<Thread>& Threads() const { return threads_; };
+
+ private:
+  int pid_ = 0;
+  std::chrono::steady_clock::time_point sampled_at_ = {};
+  // TID -> ACTIVE JIFFIES AT THE LAST SAMPLE
+  std::unordered_map<int, long> history_ = {};
+  std::vector<Thread> threads_ = {};
+};
+
+#endif
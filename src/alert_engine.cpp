@@ -0,0 +1,421 @@
+#include "alert_engine.h"
+
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "process.h"
+#include "system.h"
+
+using std::invalid_argument;
+using std::string;
+using std::to_string;
+using std::vector;
+
+namespace {
+// Reads tokens from the text of a single rule
+class Cursor {
+ public:
+  Cursor(const string& text) : text_{text} {};
+
+  bool Done() {
+    SkipSpaces();
+    return pos_ >= text_.size();
+  }
+
+  bool Accept(const string& token) {
+    SkipSpaces();
+    if (text_.compare(pos_, token.size(), token) != 0) {
+      return false;
+    }
+    pos_ += token.size();
+    return true;
+  }
+
+  void Expect(const string& token) {
+    if (!Accept(token)) {
+      throw invalid_argument("expected '" + token + "' at column " +
+                             to_string(pos_ + 1));
+    }
+  }
+
+  string Identifier() {
+    SkipSpaces();
+    size_t start = pos_;
+    while (pos_ < text_.size() &&
+           (isalnum(static_cast<unsigned char>(text_[pos_])) ||
+            text_[pos_] == '_')) {
+      ++pos_;
+    }
+    if (pos_ == start) {
+      throw invalid_argument("expected a name at column " +
+                             to_string(pos_ + 1));
+    }
+    return text_.substr(start, pos_ - start);
+  }
+
+  string Quoted() {
+    Expect("\"");
+    string value;
+    while (pos_ < text_.size() && text_[pos_] != '"') {
+      if (text_[pos_] == '\\' && pos_ + 1 < text_.size()) {
+        ++pos_;
+      }
+      value += text_[pos_++];
+    }
+    Expect("\"");
+    return value;
+  }
+
+  double Number() {
+    SkipSpaces();
+    const char* start = text_.c_str() + pos_;
+    char* end = nullptr;
+    double value = std::strtod(start, &end);
+    if (end == start) {
+      throw invalid_argument("expected a number at column " +
+                             to_string(pos_ + 1));
+    }
+    pos_ += end - start;
+    return value;
+  }
+
+ private:
+  void SkipSpaces() {
+    while (pos_ < text_.size() &&
+           isspace(static_cast<unsigned char>(text_[pos_]))) {
+      ++pos_;
+    }
+  }
+
+  const string& text_;
+  size_t pos_ = 0;
+};
+
+// Removes a '#' comment, leaving any '#' inside a quoted pattern alone
+string StripComment(const string& line) {
+  bool quoted = false;
+  for (size_t i = 0; i < line.size(); ++i) {
+    if (quoted && line[i] == '\\') {
+      ++i;
+    } else if (line[i] == '"') {
+      quoted = !quoted;
+    } else if (!quoted && line[i] == '#') {
+      return line.substr(0, i);
+    }
+  }
+  return line;
+}
+}  // namespace
+
+// Returns a one line description of a firing alert
+string AlertEngine::Alert::Describe() const {
+  return rule + " [" + subject + " = " + value + "]";
+}
+
+// Compiles every rule in a config file
+void AlertEngine::Load(const string& path) {
+  std::ifstream rules_file(path);
+  if (!rules_file.is_open()) {
+    throw invalid_argument("cannot open alert rules file " + path);
+  }
+  string line;
+  int line_number = 0;
+  while (getline(rules_file, line)) {
+    ++line_number;
+    line = StripComment(line);
+    if (line.find_first_not_of(" \t\r") == string::npos) {
+      continue;
+    }
+    try {
+      Add(line);
+    } catch (const invalid_argument& error) {
+      throw invalid_argument(path + ":" + to_string(line_number) + ": " +
+                             error.what());
+    }
+  }
+}
+
+// Compiles a single rule
+void AlertEngine::Add(const string& rule) {
+  rules_.emplace_back(Compile(rule));
+}
+
+AlertEngine::Rule AlertEngine::Compile(const string& text) {
+  Rule rule;
+  size_t start = text.find_first_not_of(" \t\r");
+  if (start == string::npos) {
+    throw invalid_argument("empty rule");
+  }
+  rule.text = text.substr(start);
+  rule.text.erase(rule.text.find_last_not_of(" \t\r") + 1);
+  Cursor cursor(rule.text);
+
+  // TARGET AND METRIC
+  string target = cursor.Identifier();
+  if (target == "proc") {
+    if (cursor.Accept("[")) {
+      string field = cursor.Identifier();
+      if (field == "cmd") {
+        rule.field = Field::kCmd;
+      } else if (field == "user") {
+        rule.field = Field::kUser;
+      } else {
+        throw invalid_argument("unknown process field '" + field + "'");
+      }
+      if (cursor.Accept("~")) {
+        rule.regex = true;
+      } else {
+        cursor.Expect("==");
+      }
+      rule.literal = cursor.Quoted();
+      if (rule.regex) {
+        try {
+          rule.pattern = std::regex(rule.literal);
+        } catch (const std::regex_error& error) {
+          throw invalid_argument("bad pattern \"" + rule.literal +
+                                 "\": " + error.what());
+        }
+      }
+      cursor.Expect("]");
+    }
+    cursor.Expect(".");
+    string metric = cursor.Identifier();
+    if (metric == "cpu") {
+      rule.metric = Metric::kProcCpu;
+    } else if (metric == "rss") {
+      rule.metric = Metric::kProcRss;
+    } else {
+      throw invalid_argument("unknown process metric '" + metric + "'");
+    }
+  } else {
+    cursor.Expect(".");
+    string metric = target + "." + cursor.Identifier();
+    if (metric == "cpu.total") {
+      rule.metric = Metric::kCpuTotal;
+    } else if (metric == "mem.used") {
+      rule.metric = Metric::kMemUsed;
+    } else if (metric == "procs.total") {
+      rule.metric = Metric::kProcsTotal;
+    } else if (metric == "procs.running") {
+      rule.metric = Metric::kProcsRunning;
+    } else {
+      throw invalid_argument("unknown metric '" + metric + "'");
+    }
+  }
+
+  // COMPARISON (TWO CHARACTER OPERATORS FIRST)
+  if (cursor.Accept(">=")) {
+    rule.op = Op::kGe;
+  } else if (cursor.Accept("<=")) {
+    rule.op = Op::kLe;
+  } else if (cursor.Accept("==")) {
+    rule.op = Op::kEq;
+  } else if (cursor.Accept("!=")) {
+    rule.op = Op::kNe;
+  } else if (cursor.Accept(">")) {
+    rule.op = Op::kGt;
+  } else if (cursor.Accept("<")) {
+    rule.op = Op::kLt;
+  } else {
+    throw invalid_argument("expected a comparison operator");
+  }
+  rule.threshold = cursor.Number();
+  if (cursor.Accept("K")) {
+    rule.threshold *= 1024.0;
+  } else if (cursor.Accept("M")) {
+    rule.threshold *= 1024.0 * 1024.0;
+  } else if (cursor.Accept("G")) {
+    rule.threshold *= 1024.0 * 1024.0 * 1024.0;
+  }
+
+  // OPTIONAL DURATION
+  rule.hold = Clock::duration::zero();
+  if (!cursor.Done()) {
+    cursor.Expect("for");
+    double seconds = cursor.Number();
+    if (cursor.Accept("h")) {
+      seconds *= 3600;
+    } else if (cursor.Accept("m")) {
+      seconds *= 60;
+    } else {
+      cursor.Expect("s");
+    }
+    rule.hold = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(seconds));
+  }
+  if (!cursor.Done()) {
+    throw invalid_argument("unexpected text after rule");
+  }
+  return rule;
+}
+
+bool AlertEngine::Compare(Op op, double value, double threshold) {
+  switch (op) {
+    case Op::kGt:
+      return value > threshold;
+    case Op::kGe:
+      return value >= threshold;
+    case Op::kLt:
+      return value < threshold;
+    case Op::kLe:
+      return value <= threshold;
+    case Op::kEq:
+      return value == threshold;
+    case Op::kNe:
+      return value != threshold;
+  }
+  return false;
+}
+
+// Applies a process rule's filter (once per process lifetime, see Evaluate)
+bool AlertEngine::Matches(const Rule& rule, Process& process) const {
+  string value;
+  switch (rule.field) {
+    case Field::kNone:
+      return true;
+    case Field::kCmd:
+      value = string(process.Command());
+      break;
+    case Field::kUser:
+      value = process.User();
+      break;
+  }
+  return rule.regex ? std::regex_search(value, rule.pattern)
+                    : value == rule.literal;
+}
+
+// Advances a condition's state and records the alert if it is firing
+void AlertEngine::Update(const Rule& rule, State& state, bool condition,
+                         int pid, const string& subject, double value,
+                         Clock::time_point now) {
+  if (!condition) {
+    if (state.firing) {
+      transitions_.emplace_back("RESOLVED " + rule.text + " [" + subject +
+                                "]");
+    }
+    state.since.reset();
+    state.firing = false;
+    return;
+  }
+  if (!state.since) {
+    state.since = now;
+  }
+  if (now - *state.since < rule.hold) {
+    return;
+  }
+
+  std::ostringstream formatted;
+  if (rule.metric == Metric::kProcRss) {
+    formatted << static_cast<long>(value / (1024 * 1024)) << "MB";
+  } else if (rule.metric == Metric::kProcsTotal ||
+             rule.metric == Metric::kProcsRunning) {
+    formatted << static_cast<long>(value);
+  } else {
+    formatted << std::fixed << std::setprecision(2) << value;
+  }
+  Alert alert{rule.text, pid, subject, formatted.str()};
+  if (!state.firing) {
+    transitions_.emplace_back("FIRING " + alert.Describe());
+  }
+  state.firing = true;
+  firing_.emplace_back(alert);
+  if (pid != 0) {
+    firing_pids_.insert(pid);
+  }
+}
+
+// Evaluates every rule against the current tick's snapshot. A process rule
+// keeps the set of processes matching its filter, updated from the
+// processes started and exited on this tick, and only visits that set.
+void AlertEngine::Evaluate(System& system, Clock::time_point now) {
+  firing_.clear();
+  firing_pids_.clear();
+  transitions_.clear();
+
+  for (Rule& rule : rules_) {
+    switch (rule.metric) {
+      case Metric::kCpuTotal: {
+        double value = system.Cpu().Utilization();
+        Update(rule, rule.state, Compare(rule.op, value, rule.threshold), 0,
+               "system", value, now);
+        continue;
+      }
+      case Metric::kMemUsed: {
+        double value = system.MemoryUtilization();
+        Update(rule, rule.state, Compare(rule.op, value, rule.threshold), 0,
+               "system", value, now);
+        continue;
+      }
+      case Metric::kProcsTotal: {
+        double value = system.TotalProcesses();
+        Update(rule, rule.state, Compare(rule.op, value, rule.threshold), 0,
+               "system", value, now);
+        continue;
+      }
+      case Metric::kProcsRunning: {
+        double value = system.RunningProcesses();
+        Update(rule, rule.state, Compare(rule.op, value, rule.threshold), 0,
+               "system", value, now);
+        continue;
+      }
+      case Metric::kProcCpu:
+      case Metric::kProcRss:
+        break;
+    }
+
+    // EXITS FIRST: A REUSED PID BOTH EXITED AND STARTED ON THIS TICK
+    for (int pid : system.ExitedProcesses()) {
+      auto matched = rule.matched.find(pid);
+      if (matched == rule.matched.end()) {
+        continue;
+      }
+      if (matched->second.firing) {
+        transitions_.emplace_back("RESOLVED " + rule.text + " [pid " +
+                                  to_string(pid) + " exited]");
+      }
+      rule.matched.erase(matched);
+    }
+    for (int pid : system.StartedProcesses()) {
+      Process* process = system.FindProcess(pid);
+      if (process != nullptr && Matches(rule, *process)) {
+        rule.matched.emplace(pid, State{});
+      }
+    }
+
+    for (auto& [pid, state] : rule.matched) {
+      Process* process = system.FindProcess(pid);
+      if (process == nullptr) {
+        continue;
+      }
+      double value = rule.metric == Metric::kProcCpu
+                         ? process->CpuUtilization()
+                         : process->RamKb() * 1024.0;
+      bool condition = Compare(rule.op, value, rule.threshold);
+      if (condition || state.firing) {
+        string subject = "pid " + to_string(pid);
+        if (!process->Command().empty()) {
+          subject += " " + string(process->Command());
+        }
+        Update(rule, state, condition, pid, subject, value, now);
+      } else {
+        state.since.reset();
+      }
+    }
+  }
+
+  if (log_ != nullptr && !transitions_.empty()) {
+    std::time_t time = std::time(nullptr);
+    for (const string& transition : transitions_) {
+      *log_ << std::put_time(std::localtime(&time), "%F %T") << " "
+            << transition << "\n";
+    }
+    log_->flush();
+  }
+}
@@ -0,0 +1,40 @@
+#include "command_arena.h"
+
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "linux_parser.h"
+
+using std::string;
+using std::string_view;
+
+// Returns the command of a process, reading it on the first call only
+string_view CommandArena::Intern(int pid, long starttime) {
+  auto key = std::make_pair(pid, starttime);
+  auto process = processes_.find(key);
+  if (process != processes_.end()) {
+    return process->second->first;
+  }
+  string command = LinuxParser::Command(pid);
+  if (command.size() > max_length_) {
+    command.resize(max_length_);
+  }
+  // unordered_map NODES NEVER MOVE, SO THE KEY CAN BE HANDED OUT AS A VIEW
+  auto interned = commands_.try_emplace(std::move(command), 0).first;
+  ++interned->second;
+  processes_.emplace(key, &*interned);
+  return interned->first;
+}
+
+// Drops a process's reference, freeing the command once it is unused
+void CommandArena::Release(int pid, long starttime) {
+  auto process = processes_.find(std::make_pair(pid, starttime));
+  if (process == processes_.end()) {
+    return;
+  }
+  if (--process->second->second == 0) {
+    commands_.erase(process->second->first);
+  }
+  processes_.erase(process);
+}
@@ -3,6 +3,8 @@
 #include <dirent.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -158,15 +160,34 @@ long LinuxParser::Jiffies() {
   return totalJiffies;
 }
 
-// Reads and returns the number of active jiffies for a PID
-long LinuxParser::ActiveJiffies(int pid) {
-  ifstream stat_file(kProcDirectory + std::to_string(pid) + kStatFilename);
+// Reads the fields of a /proc/<pid>/stat (or task stat) file, indexed as in
+// proc(5) from 0. The command name may contain spaces and parentheses, so
+// it is taken as everything between the first '(' and the last ')'.
+vector<string> LinuxParser::StatFields(const string& path) {
+  ifstream stat_file(path);
   string line;
-  if (getline(stat_file, line)) {
-    istringstream linestream(line);
-    std::istream_iterator<string> line_iterator(linestream), end_iterator;
-    std::vector<string> stat_fields(line_iterator, end_iterator);
+  vector<string> stat_fields;
+  if (!getline(stat_file, line)) {
+    return stat_fields;
+  }
+  size_t open = line.find('(');
+  size_t close = line.rfind(')');
+  if (open == string::npos || close == string::npos || close < open) {
+    return stat_fields;
+  }
+  stat_fields.emplace_back(line.substr(0, open - 1));
+  stat_fields.emplace_back(line.substr(open + 1, close - open - 1));
+  istringstream linestream(line.substr(close + 1));
+  std::istream_iterator<string> line_iterator(linestream), end_iterator;
+  stat_fields.insert(stat_fields.end(), line_iterator, end_iterator);
+  return stat_fields;
+}
 
+// Reads and returns the number of active jiffies for a PID
+long LinuxParser::ActiveJiffies(int pid) {
+  vector<string> stat_fields =
+      StatFields(kProcDirectory + std::to_string(pid) + kStatFilename);
+  if (stat_fields.size() > 16) {
     long utime = std::stol(stat_fields[13]);
     long stime = std::stol(stat_fields[14]);
     long cutime = std::stol(stat_fields[15]);
@@ -241,16 +262,93 @@ int LinuxParser::RunningProcesses() {
 }
 
 // Reads and returns the command associated with a process
-string LinuxParser::Command(int pid) { return Process(pid).Command(); }
+string LinuxParser::Command(int pid) {
+  ifstream cmd_file(kProcDirectory + to_string(pid) + kCmdlineFilename);
+  string command{std::istreambuf_iterator<char>(cmd_file),
+                 std::istreambuf_iterator<char>()};
+  // ARGUMENTS ARE NUL-SEPARATED (AND NUL-TERMINATED)
+  std::replace(command.begin(), command.end(), '\0', ' ');
+  command.erase(command.find_last_not_of(' ') + 1);
+  if (!command.empty()) {
+    return command;
+  }
+  // KERNEL THREADS HAVE NO COMMAND LINE, SHOW THEIR NAME LIKE ps DOES
+  ifstream comm_file(kProcDirectory + to_string(pid) + kCommFilename);
+  string comm;
+  if (getline(comm_file, comm) && !comm.empty()) {
+    return "[" + comm + "]";
+  }
+  return command;
+}
+
+// Reads and returns the thread ids of a process
+vector<int> LinuxParser::Tids(int pid) {
+  vector<int> tids;
+  DIR* directory =
+      opendir((kProcDirectory + to_string(pid) + kTaskDirectory).c_str());
+  // THE PROCESS HAS EXITED
+  if (directory == nullptr) {
+    return tids;
+  }
+  struct dirent* file;
+  while ((file = readdir(directory)) != nullptr) {
+    if (file->d_type == DT_DIR) {
+      string filename(file->d_name);
+      if (all_of(filename.begin(), filename.end(),
+                 [](unsigned char c) { return isdigit(c); })) {
+        tids.emplace_back(stoi(filename));
+      }
+    }
+  }
+  closedir(directory);
+  return tids;
+}
 
 // Reads and returns the memory used by a process
-string LinuxParser::Ram(int pid) { return Process(pid).Ram(); }
+string LinuxParser::Ram(int pid) {
+  Process process(pid);
+  process.Sample(0, UpTime());
+  return process.Ram();
+}
 
 // Reads and returns the user ID associated with a process
-string LinuxParser::Uid(int pid) { return Process(pid).Uid(); }
+string LinuxParser::Uid(int pid) {
+  Process process(pid);
+  process.Sample(0, UpTime());
+  return process.Uid();
+}
 
 // Reads and returns the user associated with a process
-string LinuxParser::User(int pid) { return Process(pid).User(); }
+string LinuxParser::User(int pid) {
+  Process process(pid);
+  process.Sample(0, UpTime());
+  return process.User();
+}
+
+// Reads and returns the user name for a user ID
+string LinuxParser::UserName(const string& uid) {
+  ifstream pass_file(kPasswordPath);
+  if (!pass_file.is_open()) {
+    throw std::runtime_error("cannot open password path");
+  }
+  string ps_line;
+  while (getline(pass_file, ps_line)) {
+    istringstream iss(ps_line);
+    string username, x, uid_str;
+    if (getline(iss, username, ':') && getline(iss, x, ':') &&
+        getline(iss, uid_str, ':')) {
+      if (uid_str == uid) {
+        return username;
+      }
+    }
+  }
+  return "";
+}
 
 // Reads and returns the uptime of a process
-long LinuxParser::UpTime(int pid) { return Process(pid).UpTime(); }
+long LinuxParser::UpTime(int pid) {
+  long uptime = UpTime();
+  Process process(pid);
+  process.Sample(0, uptime);
+  return process.UpTime(uptime);
+}
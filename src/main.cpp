@@ -1,9 +1,139 @@
+#include "alert_engine.h"
 #include "linux_parser.h"
 #include "ncurses_display.h"
 #include "system.h"
 using namespace std;
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <fstream>
 #include <iostream>
-int main() {
-  System system;
-  NCursesDisplay::Display(system);
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// Parses the whole-number value of an option, which must be within
+// [minimum, maximum]
+long Count(const string& flag, const string& value, long minimum,
+           long maximum = LONG_MAX) {
+  string error = "invalid value for option " + flag + ": " + value;
+  size_t end = 0;
+  long count = 0;
+  try {
+    count = stol(value, &end);
+  } catch (const logic_error&) {
+    // invalid_argument OR out_of_range
+    throw invalid_argument(error);
+  }
+  if (end != value.size() || count < minimum || count > maximum) {
+    throw invalid_argument(error);
+  }
+  return count;
+}
+
+int main(int argc, char* argv[]) {
+  // --idle-interval N: re-sample idle processes every N ticks
+  // --sample-budget N: sample at most N processes per tick (0 = unlimited)
+  // --command-length N: truncate commands to N characters
+  // --alerts FILE: evaluate the alert rules in FILE on every tick
+  // --alert-log FILE: append alert transitions to FILE
+  // --headless: no ncurses, print alert transitions to stdout
+  // --sort KEY: order processes by cpu, ram, pss, uss or swap
+  // --memory-detail: show PSS, USS and swap columns
+  // --detail-staleness N: re-read smaps_rollup after N seconds
+  int idle_interval = 5;
+  size_t sample_budget = 0;
+  size_t command_length = 256;
+  string alerts_path;
+  string alert_log_path;
+  bool headless = false;
+  System::SortKey sort_key = System::SortKey::kCpu;
+  bool memory_detail = false;
+  long detail_staleness = 5;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      string flag(argv[i]);
+      if (flag == "--headless") {
+        headless = true;
+        continue;
+      }
+      if (flag == "--memory-detail") {
+        memory_detail = true;
+        continue;
+      }
+      if (i + 1 >= argc) {
+        cerr << "missing value for option: " << flag << endl;
+        return 1;
+      }
+      string value(argv[++i]);
+      if (flag == "--idle-interval") {
+        idle_interval = Count(flag, value, 1, INT_MAX);
+      } else if (flag == "--sample-budget") {
+        sample_budget = Count(flag, value, 0);
+      } else if (flag == "--command-length") {
+        command_length = Count(flag, value, 1);
+      } else if (flag == "--alerts") {
+        alerts_path = value;
+      } else if (flag == "--alert-log") {
+        alert_log_path = value;
+      } else if (flag == "--sort") {
+        if (value == "cpu") {
+          sort_key = System::SortKey::kCpu;
+        } else if (value == "ram") {
+          sort_key = System::SortKey::kRam;
+        } else if (value == "pss") {
+          sort_key = System::SortKey::kPss;
+        } else if (value == "uss") {
+          sort_key = System::SortKey::kUss;
+        } else if (value == "swap") {
+          sort_key = System::SortKey::kSwap;
+        } else {
+          cerr << "unknown sort key: " << value << endl;
+          return 1;
+        }
+      } else if (flag == "--detail-staleness") {
+        detail_staleness = Count(flag, value, 1);
+      } else {
+        cerr << "unknown option: " << flag << endl;
+        return 1;
+      }
+    }
+  } catch (const invalid_argument& error) {
+    cerr << error.what() << endl;
+    return 1;
+  }
+
+  AlertEngine alerts;
+  if (!alerts_path.empty()) {
+    try {
+      alerts.Load(alerts_path);
+    } catch (const invalid_argument& error) {
+      cerr << error.what() << endl;
+      return 1;
+    }
+  }
+  ofstream alert_log;
+  if (!alert_log_path.empty()) {
+    alert_log.open(alert_log_path, ios::app);
+    if (!alert_log.is_open()) {
+      cerr << "cannot open alert log " << alert_log_path << endl;
+      return 1;
+    }
+    alerts.Log(alert_log);
+  } else if (headless) {
+    alerts.Log(cout);
+  }
+
+  System system(idle_interval, sample_budget, command_length);
+  system.Sort(sort_key);
+  system.MemoryDetail(memory_detail, chrono::seconds(detail_staleness));
+  if (!headless) {
+    NCursesDisplay::Display(system, alerts);
+    return 0;
+  }
+  while (true) {
+    system.Processes();
+    alerts.Evaluate(system);
+    this_thread::sleep_for(chrono::seconds(1));
+  }
 }
@@ -2,13 +2,16 @@
 
 #include <curses.h>
 
+#include <algorithm>
 #include <chrono>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
 #include "format.h"
 #include "system.h"
+#include "thread_sampler.h"
 
 using std::string;
 using std::to_string;
@@ -51,61 +54,242 @@ void NCursesDisplay::DisplaySystem(System& system, WINDOW* window) {
       ("Running Processes: " + to_string(system.RunningProcesses())).c_str());
   mvwprintw(window, ++row, 2,
             ("Up Time: " + Format::ElapsedTime(system.UpTime())).c_str());
+  mvwprintw(
+      window, ++row, 2,
+      ("Skipped Processes: " + to_string(system.SkippedProcesses())).c_str());
   wrefresh(window);
 }
 
 void NCursesDisplay::DisplayProcesses(std::vector<Process>& processes,
-                                      WINDOW* window, int n) {
+                                      const AlertEngine& alerts,
+                                      WINDOW* window, int n,
+                                      bool memory_detail, int selected,
+                                      long uptime) {
   int row{0};
   int const pid_column{2};
   int const user_column{9};
   int const cpu_column{16};
   int const ram_column{26};
-  int const time_column{35};
-  int const command_column{46};
+  int const pss_column{35};
+  int const uss_column{44};
+  int const swap_column{53};
+  int const time_column{memory_detail ? 62 : 35};
+  int const command_column{memory_detail ? 73 : 46};
+  // kB TO MB, "-" WHEN smaps_rollup COULD NOT BE READ
+  auto megabytes = [](long kb) {
+    return kb < 0 ? string("-") : to_string(kb / 1024);
+  };
   wattron(window, COLOR_PAIR(2));
   mvwprintw(window, ++row, pid_column, "PID");
   mvwprintw(window, row, user_column, "USER");
   mvwprintw(window, row, cpu_column, "CPU[%%]");
   mvwprintw(window, row, ram_column, "RAM[MB]");
+  if (memory_detail) {
+    mvwprintw(window, row, pss_column, "PSS[MB]");
+    mvwprintw(window, row, uss_column, "USS[MB]");
+    mvwprintw(window, row, swap_column, "SWAP[MB]");
+  }
   mvwprintw(window, row, time_column, "TIME+");
   mvwprintw(window, row, command_column, "COMMAND");
   wattroff(window, COLOR_PAIR(2));
-  for (int i = 0; i < n; ++i) {
+  for (int i = 0; i < n && i < static_cast<int>(processes.size()); ++i) {
+    // PROCESSES WITH A FIRING ALERT ARE SHOWN IN RED
+    bool alerting = alerts.Firing(processes[i].Pid());
+    if (alerting) {
+      wattron(window, COLOR_PAIR(3));
+    }
+    if (i == selected) {
+      wattron(window, A_REVERSE);
+    }
     mvwprintw(window, ++row, pid_column, to_string(processes[i].Pid()).c_str());
     mvwprintw(window, row, user_column, processes[i].User().c_str());
     float cpu = processes[i].CpuUtilization() * 100;
     mvwprintw(window, row, cpu_column, to_string(cpu).substr(0, 4).c_str());
     mvwprintw(window, row, ram_column, processes[i].Ram().c_str());
+    if (memory_detail) {
+      mvwprintw(window, row, pss_column,
+                megabytes(processes[i].PssKb()).c_str());
+      mvwprintw(window, row, uss_column,
+                megabytes(processes[i].UssKb()).c_str());
+      mvwprintw(window, row, swap_column,
+                megabytes(processes[i].SwapKb()).c_str());
+    }
     mvwprintw(window, row, time_column,
-              Format::ElapsedTime(processes[i].UpTime()).c_str());
-    mvwprintw(window, row, command_column,
-              processes[i].Command().substr(0, window->_maxx - 46).c_str());
+              Format::ElapsedTime(processes[i].UpTime(uptime)).c_str());
+    std::string_view command =
+        processes[i].Command().substr(0, window->_maxx - command_column);
+    mvwprintw(window, row, command_column, "%.*s",
+              static_cast<int>(command.size()), command.data());
+    if (i == selected) {
+      wattroff(window, A_REVERSE);
+    }
+    if (alerting) {
+      wattroff(window, COLOR_PAIR(3));
+    }
   }
 }
 
-void NCursesDisplay::Display(System& system, int n) {
+// Lists the threads of the selected process, busiest first
+void NCursesDisplay::DisplayThreads(const ThreadSampler& threads,
+                                    WINDOW* window, int n) {
+  int row{0};
+  int const tid_column{2};
+  int const name_column{10};
+  int const state_column{28};
+  int const cpu_column{35};
+  int const processor_column{45};
+  const std::vector<ThreadSampler::Thread>& list = threads.Threads();
+  mvwprintw(window, 0, 2, " Threads of PID %d: %zu (ESC to go back) ",
+            threads.Pid(), list.size());
+  wattron(window, COLOR_PAIR(2));
+  mvwprintw(window, ++row, tid_column, "TID");
+  mvwprintw(window, row, name_column, "NAME");
+  mvwprintw(window, row, state_column, "STATE");
+  mvwprintw(window, row, cpu_column, "CPU[%%]");
+  mvwprintw(window, row, processor_column, "LAST CPU");
+  wattroff(window, COLOR_PAIR(2));
+  if (list.empty()) {
+    mvwprintw(window, ++row, tid_column, "Process has exited");
+    return;
+  }
+  for (int i = 0; i < n && i < static_cast<int>(list.size()); ++i) {
+    mvwprintw(window, ++row, tid_column, to_string(list[i].tid).c_str());
+    mvwprintw(window, row, name_column, "%.*s", state_column - name_column - 1,
+              list[i].name.c_str());
+    mvwprintw(window, row, state_column, list[i].state.c_str());
+    float cpu = list[i].cpu_utilization * 100;
+    mvwprintw(window, row, cpu_column, to_string(cpu).substr(0, 4).c_str());
+    mvwprintw(window, row, processor_column,
+              to_string(list[i].processor).c_str());
+  }
+}
+
+// Lists the firing alerts, as many as fit in the window
+void NCursesDisplay::DisplayAlerts(const AlertEngine& alerts, WINDOW* window) {
+  int row{0};
+  int const rows{window->_maxy - 1};
+  int const width{window->_maxx - 3};
+  werase(window);
+  box(window, 0, 0);
+  const std::vector<AlertEngine::Alert>& firing = alerts.Firing();
+  if (firing.empty()) {
+    mvwprintw(window, ++row, 2, "No alerts firing");
+    return;
+  }
+  wattron(window, COLOR_PAIR(3));
+  for (size_t i = 0; i < firing.size() && row < rows; ++i) {
+    if (row == rows - 1 && i + 1 < firing.size()) {
+      mvwprintw(window, ++row, 2, "... and %zu more", firing.size() - i);
+      break;
+    }
+    mvwprintw(window, ++row, 2, "%.*s", width,
+              firing[i].Describe().c_str());
+  }
+  wattroff(window, COLOR_PAIR(3));
+}
+
+void NCursesDisplay::Display(System& system, AlertEngine& alerts, int n) {
   initscr();      // start ncurses
   noecho();       // do not print input values
   cbreak();       // terminate ncurses on ctrl + c
   start_color();  // enable color
+  set_escdelay(25);
 
   int x_max{getmaxx(stdscr)};
-  WINDOW* system_window = newwin(9, x_max - 1, 0, 0);
+  WINDOW* system_window = newwin(10, x_max - 1, 0, 0);
   WINDOW* process_window =
       newwin(3 + n, x_max - 1, system_window->_maxy + 1, 0);
+  // ONLY SHOWN WHEN ALERT RULES ARE LOADED
+  WINDOW* alert_window =
+      alerts.Size() > 0
+          ? newwin(7, x_max - 1,
+                   system_window->_maxy + process_window->_maxy + 2, 0)
+          : nullptr;
+  keypad(process_window, TRUE);
 
+  // UP/DOWN SELECT A PROCESS, ENTER SHOWS ITS THREADS, ESC GOES BACK. THE
+  // SELECTION FOLLOWS THE PROCESS (NOT THE ROW) AS THE TABLE IS RE-SORTED.
+  int selected_pid{0};
+  ThreadSampler threads;
+  // THE TABLE IS REDRAWN FROM THE LAST TICK'S VALUES ON EVERY KEY
+  std::vector<Process>* processes{nullptr};
+  long uptime{0};
+  auto next_tick = std::chrono::steady_clock::now();
   while (1) {
     init_pair(1, COLOR_BLUE, COLOR_BLACK);
     init_pair(2, COLOR_GREEN, COLOR_BLACK);
-    box(system_window, 0, 0);
+    init_pair(3, COLOR_RED, COLOR_BLACK);
+    if (std::chrono::steady_clock::now() >= next_tick) {
+      // VALUES SUCH AS THE SKIPPED COUNT CAN GET SHORTER
+      werase(system_window);
+      box(system_window, 0, 0);
+      processes = &system.Processes();
+      uptime = system.UpTime();
+      system.SampleMemoryDetail(n);
+      alerts.Evaluate(system);
+      threads.Sample();
+      DisplaySystem(system, system_window);
+      wrefresh(system_window);
+      if (alert_window != nullptr) {
+        DisplayAlerts(alerts, alert_window);
+        wrefresh(alert_window);
+      }
+      next_tick = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    }
+    int rows{std::min(n, static_cast<int>(processes->size()))};
+    int selected{-1};
+    for (int i = 0; i < rows; ++i) {
+      if ((*processes)[i].Pid() == selected_pid) {
+        selected = i;
+        break;
+      }
+    }
+    // START ON THE FIRST ROW, AND GO BACK TO IT WHEN THE SELECTED PROCESS
+    // IS NO LONGER SHOWN
+    if (selected < 0 && rows > 0) {
+      selected = 0;
+      selected_pid = (*processes)[0].Pid();
+    }
+    werase(process_window);
     box(process_window, 0, 0);
-    DisplaySystem(system, system_window);
-    DisplayProcesses(system.Processes(), process_window, n);
-    wrefresh(system_window);
+    if (threads.Pid() != 0) {
+      DisplayThreads(threads, process_window, n);
+    } else {
+      DisplayProcesses(*processes, alerts, process_window, n,
+                       system.MemoryDetail(), selected, uptime);
+    }
     wrefresh(process_window);
     refresh();
-    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    // KEYS REDRAW IMMEDIATELY, SAMPLING STILL HAPPENS ONCE PER SECOND
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+        next_tick - std::chrono::steady_clock::now());
+    wtimeout(process_window, std::max(static_cast<int>(wait.count()), 0));
+    switch (wgetch(process_window)) {
+      case KEY_UP:
+        if (rows > 0) {
+          selected_pid = (*processes)[std::max(selected - 1, 0)].Pid();
+        }
+        break;
+      case KEY_DOWN:
+        if (rows > 0) {
+          selected_pid = (*processes)[std::min(selected + 1, rows - 1)].Pid();
+        }
+        break;
+      case '\n':
+      case KEY_ENTER:
+        // ONLY A PROCESS THAT IS STILL SHOWN CAN BE OPENED
+        if (threads.Pid() == 0 && selected >= 0) {
+          threads.Select(selected_pid);
+          threads.Sample();
+        }
+        break;
+      case 27:  // ESC
+      case KEY_BACKSPACE:
+      case KEY_LEFT:
+        threads.Select(0);
+        break;
+    }
   }
   endwin();
-}
\ No newline at end of file
+}
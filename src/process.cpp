@@ -16,54 +16,107 @@ using namespace std;
 // Returns this process's ID
 int Process::Pid() { return pid_; }
 
-// Returns this process's CPU utilization
-float Process::CpuUtilization() {
-  float total_time = LinuxParser::ActiveJiffies(pid_);
-  return total_time / sysconf(_SC_CLK_TCK) / UpTime();
-}
-
-// Returns the command that generated this process
-string Process::Command() {
-  ifstream cmd_file(LinuxParser::kProcDirectory + to_string(pid_) +
-                    LinuxParser::kCmdlineFilename);
-
-  if (!cmd_file.is_open()) {
-    throw std::runtime_error("cannot open command file file");
+// Returns this process's CPU utilization (as of the last Sample())
+float Process::CpuUtilization() const { return cpu_utilization_; }
+
+// Re-reads the counters used for sorting and marks the process as active
+// when its CPU time or resident memory changed since the previous sample.
+// CPU utilization is measured since the previous sample (since the process
+// started on the first one). system_uptime is read once per tick by System.
+void Process::Sample(long tick, long system_uptime) {
+  auto now = std::chrono::steady_clock::now();
+  // ONE READ OF stat FOR BOTH THE CPU TIME AND THE START TIME
+  std::vector<std::string> stat_values = LinuxParser::StatFields(
+      LinuxParser::kProcDirectory + to_string(pid_) +
+      LinuxParser::kStatFilename);
+  if (stat_values.size() <= 21) {
+    throw std::runtime_error("cannot read stat file");
   }
-  string cmd_line;
-  getline(cmd_file, cmd_line);
-  return cmd_line;
+  // utime + stime ONLY: A REAPED CHILD'S WHOLE LIFETIME IS ADDED TO
+  // cutime/cstime AT ONCE, WHICH WOULD SHOW AS A SPIKE IN A SINGLE INTERVAL
+  long active_jiffies = std::stol(stat_values[13]) + std::stol(stat_values[14]);
+  long starttime = std::stol(stat_values[21]);
+  long ram_kb = 0;
+  long swap_kb = 0;
+  string uid;
+  ReadStatus(ram_kb, swap_kb, uid);
+  long uptime = system_uptime - starttime / sysconf(_SC_CLK_TCK);
+
+  // A DIFFERENT START TIME MEANS THE PID WAS REUSED BY A NEW PROCESS
+  if (starttime != starttime_) {
+    sampled_ = false;
+    starttime_ = starttime;
+    // THE USER IS RESOLVED ONCE PER PROCESS LIFETIME
+    uid_ = uid;
+    user_ = LinuxParser::UserName(uid);
+    detail_time_.reset();
+    pss_kb_ = -1;
+    uss_kb_ = -1;
+  }
+  active_ = !sampled_ || active_jiffies != active_jiffies_ || ram_kb != ram_kb_;
+  float elapsed = std::chrono::duration<float>(now - sampled_at_).count();
+  if (sampled_ && elapsed > 0) {
+    cpu_utilization_ = (active_jiffies - active_jiffies_) /
+                       static_cast<float>(sysconf(_SC_CLK_TCK)) / elapsed;
+  } else {
+    // A PROCESS STARTED WITHIN THE LAST SECOND HAS AN UPTIME OF 0
+    cpu_utilization_ = uptime > 0 ? static_cast<float>(active_jiffies) /
+                                        sysconf(_SC_CLK_TCK) / uptime
+                                  : 0.0f;
+  }
+  sampled_ = true;
+  sampled_at_ = now;
+  sampled_tick_ = tick;
+  active_jiffies_ = active_jiffies;
+  ram_kb_ = ram_kb;
+  swap_kb_ = swap_kb;
 }
 
-// Returns this process's memory utilization
-string Process::Ram() {
-  ifstream status_file(LinuxParser::kProcDirectory + to_string(pid_) +
-                       LinuxParser::kStatusFilename);
-  if (!status_file.is_open()) {
-    throw std::runtime_error("cannot open status file");
+// Returns this process's memory utilization (as of the last Sample())
+string Process::Ram() const { return to_string(ram_kb_ / 1024); }
+
+// Reads the proportional (PSS) and unique (USS) set sizes from smaps_rollup,
+// which is expensive for the kernel to produce
+void Process::SampleMemoryDetail(std::chrono::steady_clock::time_point now) {
+  detail_time_ = now;
+  pss_kb_ = -1;
+  uss_kb_ = -1;
+  // OTHER USERS' PROCESSES ARE NOT READABLE WITHOUT ptrace ACCESS
+  ifstream smaps_file(LinuxParser::kProcDirectory + to_string(pid_) +
+                      LinuxParser::kSmapsRollupFilename);
+  if (!smaps_file.is_open()) {
+    return;
   }
+  // KERNEL THREADS HAVE AN EMPTY FILE, AND NO USER MEMORY
+  pss_kb_ = 0;
+  uss_kb_ = 0;
   string line;
-  string ram;
-  while (getline(status_file, line)) {
+  while (getline(smaps_file, line)) {
     istringstream iss(line);
     string key;
     long value;
     if (iss >> key >> value) {
-      // kSystemProcMem == VmRss
-      // I avoided using VmSize based on a reviewer's comments since it gives
-      // the physical size + the virtual size
-      if (key == LinuxParser::kSystemProcMem) {
-        ram = to_string(value / 1024);
-        break;
+      if (key == LinuxParser::kSmapsPss) {
+        pss_kb_ = value;
+      } else if (key == LinuxParser::kSmapsPrivateClean ||
+                 key == LinuxParser::kSmapsPrivateDirty) {
+        uss_kb_ += value;
       }
     }
   }
-  return ram;
 }
 
-// Returns the user (name) that generated this process
-string Process::User() {
-  // FIND UID
+// Whether the memory detail was read less than staleness ago (or at now)
+bool Process::MemoryDetailFresh(
+    std::chrono::steady_clock::time_point now,
+    std::chrono::steady_clock::duration staleness) const {
+  return detail_time_ &&
+         (*detail_time_ == now || now - *detail_time_ < staleness);
+}
+
+// Reads this process's resident set size and swap usage (in kB) and its
+// user ID from the status file
+void Process::ReadStatus(long& ram_kb, long& swap_kb, string& uid) {
   ifstream status_file(LinuxParser::kProcDirectory + to_string(pid_) +
                        LinuxParser::kStatusFilename);
   if (!status_file.is_open()) {
@@ -75,65 +128,34 @@ string Process::User() {
     string key;
     long value;
     if (iss >> key >> value) {
+      // kSystemProcMem == VmRss
+      // I avoided using VmSize based on a reviewer's comments since it gives
+      // the physical size + the virtual size
       if (key == LinuxParser::kUserUID) {
-        uid_ = to_string(value);
+        uid = to_string(value);
+      } else if (key == LinuxParser::kSystemProcMem) {
+        ram_kb = value;
+      } else if (key == LinuxParser::kSystemProcSwap) {
+        // VmSwap COMES AFTER Uid AND VmRSS
+        swap_kb = value;
         break;
       }
     }
   }
-  // FIND USER CORRESPONDING TO UID
-  string user;
-  ifstream pass_file(LinuxParser::kPasswordPath);
-  if (!pass_file.is_open()) {
-    throw std::runtime_error("cannot open password path");
-  }
-  string ps_line;
-  while (getline(pass_file, ps_line)) {
-    istringstream iss(ps_line);
-    std::string username, x, uid_str;
-    if (getline(iss, username, ':') && getline(iss, x, ':') &&
-        getline(iss, uid_str, ':')) {
-      try {
-        if (uid_str == uid_) {
-          return username;
-        }
-      } catch (...) {
-        // IGNORE TO CHECK NEXT LINE
-      }
-    }
-  }
-  return "";
 }
 
-// Returns the age of this process (in seconds)
-long int Process::UpTime() {
-  ifstream stat_file(LinuxParser::kProcDirectory + to_string(pid_) +
-                     LinuxParser::kStatFilename);
-  if (!stat_file.is_open()) {
-    throw std::runtime_error("Cannot open stat file");
+// Returns the age of this process (in seconds) given the system's uptime
+long int Process::UpTime(long system_uptime) const {
+  // NOT SAMPLED YET
+  if (starttime_ < 0) {
+    return 0;
   }
-
-  std::string line;
-  std::getline(stat_file, line);
-  istringstream iss(line);
-
-  // POPULATE THE VECTOR WITH ALL VALUES FROM ISS FROM START TO END
-  std::vector<std::string> stat_values(std::istream_iterator<std::string>{iss},
-                                       std::istream_iterator<std::string>());
-
-  if (stat_values.size() <= 21) {
-    throw std::runtime_error("Invalid stat file format");
-  }
-
-  // START TIME VALUE IS THE 22nd IN THE FILE
-  long int starttime = std::stol(stat_values[21]);
-  long int sys_uptime = LinuxParser::UpTime();
   long int clock_ticks = sysconf(_SC_CLK_TCK);
 
   // WE DIVIDE starttime by clock_ticks TO GET TIME IN SECONDS
-  return sys_uptime - (starttime / clock_ticks);
+  return system_uptime - (starttime_ / clock_ticks);
 }
 
-bool Process::operator<(Process& a) {
+bool Process::operator<(const Process& a) const {
   return CpuUtilization() < a.CpuUtilization();
 }
\ No newline at end of file
@@ -5,22 +5,37 @@
 
 // Returns the aggregate CPU utilization
 float Processor::Utilization() {
-  std::vector<std::string> utilization = LinuxParser::CpuUtilization();
+  if (!sampled_) {
+    Sample();
+  }
+  return utilization_;
+}
 
-  float user = std::stof(utilization[0]);
-  float nice = std::stof(utilization[1]);
-  float system = std::stof(utilization[2]);
-  float idle = std::stof(utilization[3]);
-  float iowait = std::stof(utilization[4]);
-  float irq = std::stof(utilization[5]);
-  float softirq = std::stof(utilization[6]);
-  float steal = std::stof(utilization[7]);
+// Reads the CPU counters; the utilization is measured since the previous
+// call (since boot on the first one)
+void Processor::Sample() {
+  std::vector<std::string> utilization = LinuxParser::CpuUtilization();
 
-  float idle_time = idle + iowait;
-  float non_idle_time = user + nice + system + irq + softirq + steal;
-  float total_time = idle_time + non_idle_time;
+  long user = std::stol(utilization[0]);
+  long nice = std::stol(utilization[1]);
+  long system = std::stol(utilization[2]);
+  long idle = std::stol(utilization[3]);
+  long iowait = std::stol(utilization[4]);
+  long irq = std::stol(utilization[5]);
+  long softirq = std::stol(utilization[6]);
+  long steal = std::stol(utilization[7]);
 
-  float utilization_percentage = (total_time - idle_time) / total_time;
+  long idle_time = idle + iowait;
+  long non_idle_time = user + nice + system + irq + softirq + steal;
 
-  return utilization_percentage;
+  long idle_delta = idle_time - prev_total_idle_time_;
+  long active_delta = non_idle_time - prev_total_active_time_;
+  // NO JIFFY HAS PASSED SINCE THE PREVIOUS CALL
+  if (idle_delta + active_delta > 0) {
+    utilization_ =
+        static_cast<float>(active_delta) / (idle_delta + active_delta);
+  }
+  prev_total_idle_time_ = idle_time;
+  prev_total_active_time_ = non_idle_time;
+  sampled_ = true;
 }
@@ -2,9 +2,12 @@
 
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstddef>
 #include <set>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "linux_parser.h"
@@ -16,16 +19,176 @@ using namespace std;
 // Returns the system's CPU
 Processor& System::Cpu() { return cpu_; }
 
-// Returns a container composed of the system's processes
+// New and active processes are sampled on every tick, idle ones every
+// idle_interval_ ticks. The pid offset spreads the idle processes evenly
+// across ticks; one that missed its turn (see sample_budget_) stays due.
+bool System::Due(int pid, const Process& process) const {
+  return !process.Sampled() || process.Active() ||
+         (pid + tick_) % idle_interval_ == 0 ||
+         tick_ - process.SampledTick() > idle_interval_;
+}
+
+// Tick by which a process should have been sampled. It only moves when the
+// process is sampled, so a process waiting for the budget is eventually the
+// most overdue one.
+long System::Deadline(const Process& process) const {
+  if (!process.Sampled()) {
+    return process.SampledTick();
+  }
+  return process.SampledTick() + (process.Active() ? 1 : idle_interval_);
+}
+
+// Returns the tracked process with this pid
+Process* System::FindProcess(int pid) {
+  auto tracked = tracked_processes_.find(pid);
+  return tracked != tracked_processes_.end() ? &tracked->second : nullptr;
+}
+
+// PSS and USS are never larger than RSS, so RSS stands in for them until
+// smaps_rollup has been read (see SampleMemoryDetail)
+double System::SortValue(const Process& process) const {
+  switch (sort_key_) {
+    case SortKey::kCpu:
+      return process.CpuUtilization();
+    case SortKey::kRam:
+      return process.RamKb();
+    case SortKey::kPss:
+      return process.PssKb() >= 0 ? process.PssKb() : process.RamKb();
+    case SortKey::kUss:
+      return process.UssKb() >= 0 ? process.UssKb() : process.RamKb();
+    case SortKey::kSwap:
+      return process.SwapKb();
+  }
+  return 0;
+}
+
+// Returns a container composed of the system's processes, sorted by the
+// sort key (highest first)
 vector<Process>& System::Processes() {
-  processes_.clear();
+  ++tick_;
+  cpu_.Sample();
+  started_.clear();
+  exited_.clear();
+  map<int, Process> current;
   for (int& pid : LinuxParser::Pids()) {
-    processes_.emplace_back(pid);
+    auto tracked = tracked_processes_.find(pid);
+    if (tracked != tracked_processes_.end()) {
+      current.emplace(pid, std::move(tracked->second));
+      tracked_processes_.erase(tracked);
+    } else {
+      current.emplace(pid, Process(pid, tick_));
+    }
+  }
+  // WHAT IS LEFT HAS EXITED
+  for (auto& [pid, process] : tracked_processes_) {
+    commands_.Release(pid, process.StartTime());
+    if (process.Sampled()) {
+      exited_.emplace_back(pid);
+    }
   }
-  std::sort(processes_.begin(), processes_.end());
+  tracked_processes_.swap(current);
+
+  // THE BUDGET GOES TO THE MOST OVERDUE PROCESSES (NEW AND ACTIVE ONES ARE
+  // DUE SOONER THAN IDLE ONES)
+  vector<Process*> queue;
+  skipped_processes_ = 0;
+  for (auto& [pid, process] : tracked_processes_) {
+    if (Due(pid, process)) {
+      queue.emplace_back(&process);
+    } else {
+      ++skipped_processes_;
+    }
+  }
+  if (sample_budget_ != 0 && queue.size() > sample_budget_) {
+    std::stable_sort(queue.begin(), queue.end(),
+                     [this](const Process* a, const Process* b) {
+                       return Deadline(*a) < Deadline(*b);
+                     });
+    skipped_processes_ += queue.size() - sample_budget_;
+    queue.resize(sample_budget_);
+  }
+
+  long uptime = LinuxParser::UpTime();
+  vector<int> exited;
+  for (Process* process : queue) {
+    try {
+      long starttime = process->StartTime();
+      process->Sample(tick_, uptime);
+      // COMMAND LINES ARE READ ONCE PER PROCESS LIFETIME
+      if (process->StartTime() != starttime) {
+        // THE PREVIOUS PROCESS WITH THIS PID EXITED FIRST
+        if (starttime != -1) {
+          exited_.emplace_back(process->Pid());
+        }
+        started_.emplace_back(process->Pid());
+        commands_.Release(process->Pid(), starttime);
+        process->Command(
+            commands_.Intern(process->Pid(), process->StartTime()));
+      }
+    } catch (const std::runtime_error&) {
+      // THE PROCESS EXITED BETWEEN Pids() AND Sample()
+      exited.emplace_back(process->Pid());
+    }
+  }
+  for (int pid : exited) {
+    auto tracked = tracked_processes_.find(pid);
+    commands_.Release(pid, tracked->second.StartTime());
+    if (tracked->second.Sampled()) {
+      exited_.emplace_back(pid);
+    }
+    tracked_processes_.erase(tracked);
+  }
+
+  processes_.clear();
+  for (auto& [pid, process] : tracked_processes_) {
+    processes_.emplace_back(process);
+  }
+  std::sort(processes_.begin(), processes_.end(),
+            [this](const Process& a, const Process& b) {
+              return SortValue(a) > SortValue(b);
+            });
   return processes_;
 }
 
+// Reads smaps_rollup for the first rows processes (the visible ones) unless
+// their cached values are still fresh. When sorting by PSS or USS a process
+// moves down to its place once its real value replaces the RSS estimate,
+// so reading continues until the first rows all have real values. Each
+// process is read at most once per call.
+void System::SampleMemoryDetail(size_t rows) {
+  if (!MemoryDetail()) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  bool reorder = sort_key_ == SortKey::kPss || sort_key_ == SortKey::kUss;
+  auto higher = [this](const Process& a, const Process& b) {
+    return SortValue(a) > SortValue(b);
+  };
+  size_t i = 0;
+  while (i < rows && i < processes_.size()) {
+    Process& process = processes_[i];
+    if (process.MemoryDetailFresh(now, detail_staleness_)) {
+      ++i;
+      continue;
+    }
+    // CACHE ON THE TRACKED PROCESS SO THE VALUES SURVIVE THE NEXT TICK
+    Process* tracked = FindProcess(process.Pid());
+    if (tracked == nullptr) {
+      ++i;
+      continue;
+    }
+    tracked->SampleMemoryDetail(now);
+    process = *tracked;
+    if (!reorder) {
+      ++i;
+      continue;
+    }
+    auto next = processes_.begin() + i + 1;
+    auto place = std::upper_bound(next, processes_.end(), process, higher);
+    std::rotate(processes_.begin() + i, next, place);
+  }
+}
+
 // Returns the system's kernel identifier (string)
 std::string System::Kernel() { return LinuxParser::Kernel(); }
 
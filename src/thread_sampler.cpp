@@ -0,0 +1,64 @@
+#include "thread_sampler.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "linux_parser.h"
+
+using std::string;
+using std::to_string;
+using std::vector;
+
+// Selects the process whose threads are sampled
+void ThreadSampler::Select(int pid) {
+  pid_ = pid;
+  history_.clear();
+  threads_.clear();
+}
+
+// Reads every thread of the selected process. CPU utilization is the share
+// of one CPU used since the previous sample (0 on the first one).
+void ThreadSampler::Sample() {
+  threads_.clear();
+  if (pid_ == 0) {
+    return;
+  }
+  auto now = std::chrono::steady_clock::now();
+  float elapsed = std::chrono::duration<float>(now - sampled_at_).count();
+  long clock_ticks = sysconf(_SC_CLK_TCK);
+
+  std::unordered_map<int, long> current;
+  for (int tid : LinuxParser::Tids(pid_)) {
+    vector<string> stat_fields = LinuxParser::StatFields(
+        LinuxParser::kProcDirectory + to_string(pid_) +
+        LinuxParser::kTaskDirectory + to_string(tid) +
+        LinuxParser::kStatFilename);
+    // THE THREAD EXITED WHILE SCANNING
+    if (stat_fields.size() <= 38) {
+      continue;
+    }
+    long active_jiffies =
+        std::stol(stat_fields[13]) + std::stol(stat_fields[14]);
+    Thread thread{tid, stat_fields[1], stat_fields[2],
+                  std::stoi(stat_fields[38]), 0.0f};
+    auto previous = history_.find(tid);
+    if (previous != history_.end() && elapsed > 0) {
+      thread.cpu_utilization =
+          (active_jiffies - previous->second) / (elapsed * clock_ticks);
+    }
+    current.emplace(tid, active_jiffies);
+    threads_.emplace_back(thread);
+  }
+  history_.swap(current);
+  sampled_at_ = now;
+
+  std::sort(threads_.begin(), threads_.end(),
+            [](const Thread& a, const Thread& b) {
+              return a.cpu_utilization > b.cpu_utilization;
+            });
+}